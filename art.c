@@ -6,58 +6,95 @@
 
 static VALUE mArtC;
 
+/**
+ * play = proc do |classified_event, instrument, velocity|
+ *   classified_event["channel"] = instrument.channel
+ *   classified_event["note"] = instrument.play(velocity)
+ *   classified_event["velocity"] = velocity
+ * end
+ */
+static void play(VALUE classified_event, VALUE instrument, int velocity) {
+  VALUE note = rb_funcall(instrument, rb_intern("play"), 1, INT2FIX(velocity));
+  rb_hash_aset(classified_event, rb_str_new_cstr("channel"), rb_funcall(instrument, rb_intern("channel"), 0));
+  rb_hash_aset(classified_event, rb_str_new_cstr("note"), note);
+  rb_hash_aset(classified_event, rb_str_new_cstr("velocity"), INT2FIX(velocity));
+}
+
 /**
  * handle_event = proc do |payload, sound_palette|
  *   type = payload["type"]
+ *   classified_event = {
+ *     "type" => type, "event" => nil, "channel" => nil, "note" => nil, "velocity" => nil,
+ *     "timestamp" => payload["timestamp"]
+ *   }
  *   if type == "track"
  *     event = payload["event"]
+ *     classified_event["event"] = event
  *     if event == "Artwork impressions"
  *       velocity = payload["userId"] == nil ? 80 : 127
- *       sound_palette.bass.play(velocity)
+ *       play.call(classified_event, sound_palette.bass, velocity)
  *     else
  *       include_list = ["Clicked \"Bid\"", "Clicked buy now", "Clicked make offer"]
  *       if include_list.includes?(event)
- *         sound_palette.bell.play(127)
+ *         play.call(classified_event, sound_palette.bell, 127)
  *       end
  *     end
  *     puts "EVENT TRACK: #{event}"
  *   elsif type == "page"
- *     sound_palette.xylophone.play(127)
+ *     play.call(classified_event, sound_palette.xylophone, 127)
+ *     classified_event["event"] = payload["properties"]["path"].to_s
  *     puts "EVENT PAGE: #{payload["properties"]["path"].inspect}"
  *   elsif type == "identify"
  *     collector_level = payload["traits"]["collector_level"] || 0
  *     velocity = collector_level == 0 ? 70 : collector_level == 1 ? 90 : collector_level == 2 ? 110 : 127
- *     sound_palette.bell.play(velocity)
+ *     play.call(classified_event, sound_palette.harp, velocity)
+ *     classified_event["event"] = collector_level.to_s
  *     puts "EVENT IDENTIFY: #{collector_level}"
+ *   else
+ *     return nil
  *   end
- *   nil
+ *   classified_event
  * end
+ *
+ * The returned classified event, of which `event` is always a string, is what gets published to the server's event
+ * stream, after the sound has been played.
  */
 static VALUE handle_event(RB_BLOCK_CALL_FUNC_ARGLIST(payload, sound_palette)) {
   VALUE type = rb_hash_fetch(payload, rb_str_new_cstr("type"));
+
+  VALUE classified_event = rb_hash_new();
+  rb_hash_aset(classified_event, rb_str_new_cstr("type"), type);
+  rb_hash_aset(classified_event, rb_str_new_cstr("event"), Qnil);
+  rb_hash_aset(classified_event, rb_str_new_cstr("channel"), Qnil);
+  rb_hash_aset(classified_event, rb_str_new_cstr("note"), Qnil);
+  rb_hash_aset(classified_event, rb_str_new_cstr("velocity"), Qnil);
+  rb_hash_aset(classified_event, rb_str_new_cstr("timestamp"), rb_hash_aref(payload, rb_str_new_cstr("timestamp")));
+
   // Track
   if (rb_str_equal(type, rb_str_new_cstr("track")) == Qtrue) {
     VALUE event = rb_hash_fetch(payload, rb_str_new_cstr("event"));
+    rb_hash_aset(classified_event, rb_str_new_cstr("event"), event);
     if (rb_str_equal(event, rb_str_new_cstr("Artwork impressions")) == Qtrue) {
       int velocity = rb_hash_fetch(payload, rb_str_new_cstr("userId")) == Qnil ? 80 : 127;
-      rb_funcall(rb_funcall(sound_palette, rb_intern("bass"), 0), rb_intern("play"), 1, INT2FIX(velocity));
+      play(classified_event, rb_funcall(sound_palette, rb_intern("bass"), 0), velocity);
     } else {
       VALUE include_list = rb_ary_new();
       rb_ary_push(include_list, rb_str_new_cstr("Clicked \"Bid\""));
       rb_ary_push(include_list, rb_str_new_cstr("Clicked buy now"));
       rb_ary_push(include_list, rb_str_new_cstr("Clicked make offer"));
       if (rb_ary_includes(include_list, event) == Qtrue) {
-        rb_funcall(rb_funcall(sound_palette, rb_intern("bell"), 0), rb_intern("play"), 1, INT2FIX(127));
+        play(classified_event, rb_funcall(sound_palette, rb_intern("bell"), 0), 127);
       }
     }
     printf("EVENT TRACK: %s\n", StringValuePtr(event));
   }
   // Page
   else if (rb_str_equal(type, rb_str_new_cstr("page")) == Qtrue) {
-    rb_funcall(rb_funcall(sound_palette, rb_intern("xylophone"), 0), rb_intern("play"), 1, INT2FIX(127));
+    play(classified_event, rb_funcall(sound_palette, rb_intern("xylophone"), 0), 127);
 
     VALUE properties = rb_hash_fetch(payload, rb_str_new_cstr("properties"));
     VALUE path = rb_hash_fetch(properties, rb_str_new_cstr("path"));
+    rb_hash_aset(classified_event, rb_str_new_cstr("event"), rb_obj_as_string(path));
     VALUE path_str = rb_inspect(path);
     printf("EVENT PAGE: %s\n", StringValuePtr(path_str));
   }
@@ -68,12 +105,17 @@ static VALUE handle_event(RB_BLOCK_CALL_FUNC_ARGLIST(payload, sound_palette)) {
 
     int cl = collector_level == Qnil ? 0 : FIX2INT(collector_level);
     int velocity = cl == 0 ? 70 : cl == 1 ? 90 : cl == 2 ? 110 : 127;
-    rb_funcall(rb_funcall(sound_palette, rb_intern("harp"), 0), rb_intern("play"), 1, INT2FIX(velocity));
+    play(classified_event, rb_funcall(sound_palette, rb_intern("harp"), 0), velocity);
+    rb_hash_aset(classified_event, rb_str_new_cstr("event"), rb_obj_as_string(INT2FIX(cl)));
 
     VALUE collector_level_str = rb_inspect(collector_level);
     printf("EVENT IDENTIFY: %s\n", StringValuePtr(collector_level_str));
   }
-  return Qnil;
+  // Unknown
+  else {
+    return Qnil;
+  }
+  return classified_event;
 }
 
 /**
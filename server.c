@@ -1,28 +1,488 @@
 #include "ext.h"
+#include <ctype.h>
+#include <limits.h>
 #include <ruby.h>
+#include <sys/resource.h>
 
 #define HTTP_STATUS_OK 200
 #define HTTP_STATUS_NOT_FOUND 404
 #define HTTP_STATUS_METHOD_NOT_ALLOWED 405
+#define HTTP_STATUS_SERVICE_UNAVAILABLE 503
+#define HTTP_STATUS_HTTP_VERSION_NOT_SUPPORTED 505
+#define HTTP_MAX_WEBHOOK_CLIENTS 100
+// Open files that are not connections: stdio, the listening sockets, Ruby's timer thread, CoreAudio/CoreMIDI, etc.
+#define HTTP_RESERVED_OPEN_FILES 64
+
+#define EVENT_STREAM_CAPACITY 256
+#define EVENT_STREAM_HEARTBEAT_INTERVAL 15
+// Every subscriber holds on to one socket and one WEBrick connection thread
+#define EVENT_STREAM_MAX_SUBSCRIBERS 512
 
 static VALUE mArtC;
+static VALUE cEventStream;
+
+#pragma mark -
+#pragma mark EventStream class
+
+/**
+ * The struct we will use as the EventStream class' native instance variable. It is a ring buffer of serialized
+ * Server-Sent Events frames, shared by all subscribers, of which `head` is the sequence number of the next frame to be
+ * published. Every subscriber keeps its own cursor into it. Frames are stored chunk-encoded, so that they can be
+ * written to the sockets of all subscribers as-is, as part of their chunked responses.
+ *
+ * Frame IDs are prefixed with `boot`, which is random per instance, so that IDs handed out before a restart are never
+ * mistaken for frames of the current run.
+ */
+struct EventStreamData {
+  VALUE frames[EVENT_STREAM_CAPACITY];
+  unsigned long head;
+  unsigned int boot;
+  int max_subscribers;
+  int subscribers;
+  int closed;
+  VALUE mutex;
+  VALUE published;
+  VALUE notifications;
+  VALUE sockets;
+};
+
+/**
+ * Tell Ruby about the frames and synchronization objects that the native instance variable holds on to.
+ */
+static void event_stream_mark(struct EventStreamData *data) {
+  for (int i = 0; i < EVENT_STREAM_CAPACITY; i++) {
+    rb_gc_mark(data->frames[i]);
+  }
+  rb_gc_mark(data->mutex);
+  rb_gc_mark(data->published);
+  rb_gc_mark(data->notifications);
+  rb_gc_mark(data->sockets);
+}
+
+/**
+ * Tell Ruby the memory size of our native instance variable.
+ */
+static size_t event_stream_size(const void *data) { return sizeof(struct EventStreamData); }
+
+/**
+ * Describes the native Ruby instance variable that will hold our `struct EventStreamData` data.
+ */
+static const rb_data_type_t event_stream_type = {
+    .wrap_struct_name = "event_stream",
+    .function =
+        {
+            .dmark = (void (*)(void *))event_stream_mark,
+            .dfree = RUBY_DEFAULT_FREE,
+            .dsize = event_stream_size,
+        },
+    .data = NULL,
+    .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+/**
+ * module ArtC
+ *   class EventStream
+ *     def self.allocate
+ *       # [No Ruby]
+ *       #
+ *       # Memory is allocated for the instance data, which holds an empty ring of frames, the mutex/condition variable
+ *       # pair that subscribers wait on for new frames to be published, the queue that wakes up the notifier, and the
+ *       # set of sockets that are being streamed to.
+ *     end
+ *   end
+ * end
+ */
+static VALUE event_stream_alloc(VALUE self) {
+  struct EventStreamData *data;
+  VALUE event_stream = TypedData_Make_Struct(self, struct EventStreamData, &event_stream_type, data);
+
+  for (int i = 0; i < EVENT_STREAM_CAPACITY; i++) {
+    data->frames[i] = Qnil;
+  }
+  data->head = 0;
+  data->boot = rb_genrand_int32();
+  data->max_subscribers = 0;
+  data->subscribers = 0;
+  data->closed = 0;
+  data->mutex = rb_mutex_new();
+  data->published = rb_class_new_instance(0, NULL, rb_const_get(rb_cThread, rb_intern("ConditionVariable")));
+  data->notifications = rb_class_new_instance(0, NULL, rb_const_get(rb_cThread, rb_intern("Queue")));
+  data->sockets = rb_hash_new();
+  return event_stream;
+}
+
+/**
+ * [No Ruby]
+ *
+ * Encodes `payload` as a single chunk of a chunked HTTP response body.
+ */
+static VALUE event_stream_chunk(VALUE payload) {
+  return rb_str_freeze(rb_sprintf("%lx\r\n%" PRIsVALUE "\r\n", (unsigned long)RSTRING_LEN(payload), payload));
+}
+
+/**
+ * [No Ruby]
+ *
+ * Closing a socket that is in use by a subscriber makes its write raise, which is all there is to do here.
+ */
+static VALUE event_stream_ignore_error(VALUE arg, VALUE error) { return Qnil; }
+
+/**
+ * [No Ruby]
+ *
+ * Closes a subscriber's socket.
+ */
+static VALUE event_stream_close_socket(VALUE socket) { return rb_io_close(socket); }
+
+/**
+ * [No Ruby]
+ *
+ * Wakes up all subscribers that are waiting for a new frame. This is only ever called with the mutex held.
+ */
+static VALUE event_stream_broadcast(VALUE published) { return rb_funcall(published, rb_intern("broadcast"), 0); }
+
+/**
+ * notify_subscribers = proc do |_, event_stream|
+ *   loop do
+ *     event_stream.notifications.pop
+ *     event_stream.notifications.clear
+ *     event_stream.mutex.synchronize { event_stream.published.broadcast }
+ *     break if event_stream.closed
+ *   end
+ *   event_stream.sockets.keys.each do |socket|
+ *     socket.close
+ *   rescue IOError, SystemCallError
+ *   end
+ * end
+ *
+ * Waking up every waiting subscriber is work proportional to their number, so it is done here rather than by the
+ * publisher. Notifications that arrive while broadcasting are coalesced into a single next broadcast.
+ *
+ * Once closed, the sockets of all subscribers are closed as well, as a subscriber whose client stopped reading is stuck
+ * writing to it and would otherwise never notice. WEBrick waits for their connection threads when shutting down.
+ */
+static VALUE event_stream_notify_subscribers(RB_BLOCK_CALL_FUNC_ARGLIST(_, event_stream)) {
+  struct EventStreamData *data;
+  TypedData_Get_Struct(event_stream, struct EventStreamData, &event_stream_type, data);
+
+  for (;;) {
+    rb_funcall(data->notifications, rb_intern("pop"), 0);
+    rb_funcall(data->notifications, rb_intern("clear"), 0);
+    rb_mutex_synchronize(data->mutex, event_stream_broadcast, data->published);
+    if (data->closed) {
+      break;
+    }
+  }
+
+  VALUE sockets = rb_funcall(data->sockets, rb_intern("keys"), 0);
+  for (long i = 0; i < RARRAY_LEN(sockets); i++) {
+    rb_rescue2(event_stream_close_socket, RARRAY_AREF(sockets, i), event_stream_ignore_error, Qnil, rb_eIOError,
+               rb_eSystemCallError, (VALUE)0);
+  }
+
+  return Qnil;
+}
+
+/**
+ * module ArtC
+ *   class EventStream
+ *     def initialize(max_subscribers)
+ *       @max_subscribers = max_subscribers
+ *       Thread.new { notify_subscribers.call(nil, self) }
+ *     end
+ *   end
+ * end
+ */
+static VALUE event_stream_initialize(VALUE self, VALUE max_subscribers) {
+  struct EventStreamData *data;
+  TypedData_Get_Struct(self, struct EventStreamData, &event_stream_type, data);
+  data->max_subscribers = NUM2INT(max_subscribers);
+
+  rb_funcall_with_block(rb_cThread, rb_intern("new"), 0, NULL, rb_proc_new(event_stream_notify_subscribers, self));
+  return self;
+}
+
+/**
+ * module ArtC
+ *   class EventStream
+ *     def publish(classified_event)
+ *       data = JSON.generate(classified_event)
+ *       frame = "id: #{@boot}-#{@head}\nevent: #{classified_event["type"]}\ndata: #{data}\n\n"
+ *       @frames[@head % EVENT_STREAM_CAPACITY] = "#{frame.bytesize.to_s(16)}\r\n#{frame}\r\n".freeze
+ *       @head += 1
+ *       @notifications << true
+ *       nil
+ *     end
+ *   end
+ * end
+ *
+ * The event is serialized, and chunk-encoded, exactly once and the publisher only wakes up the notifier, so the work
+ * done here does not grow with the number of subscribers. What each subscriber does cost is a thread wake-up and a
+ * write of the shared frame to its socket, which happen under the GVL that it shares with the rest of the server.
+ */
+static VALUE event_stream_publish(VALUE self, VALUE classified_event) {
+  struct EventStreamData *data;
+  TypedData_Get_Struct(self, struct EventStreamData, &event_stream_type, data);
+
+  VALUE rb_mJSON = rb_const_get(rb_cObject, rb_intern("JSON"));
+  VALUE json = rb_funcall(rb_mJSON, rb_intern("generate"), 1, classified_event);
+  VALUE type = rb_hash_aref(classified_event, rb_str_new_cstr("type"));
+
+  // Frames are stored in order of publishing, which can only be guaranteed by taking the sequence number after the
+  // Ruby calls above, as those may have switched to another thread that is publishing too.
+  unsigned long sequence = data->head;
+  VALUE frame = rb_sprintf("id: %08x-%lu\nevent: %" PRIsVALUE "\ndata: %" PRIsVALUE "\n\n", data->boot, sequence,
+                           type, json);
+  data->frames[sequence % EVENT_STREAM_CAPACITY] = event_stream_chunk(frame);
+  data->head = sequence + 1;
+
+  rb_funcall(data->notifications, rb_intern("push"), 1, Qtrue);
+
+  return Qnil;
+}
+
+/**
+ * module ArtC
+ *   class EventStream
+ *     def full?
+ *       @closed || @subscribers >= @max_subscribers
+ *     end
+ *   end
+ * end
+ *
+ * Subscribers are capped, so that connections and open files stay available for the webhooks.
+ */
+static VALUE event_stream_is_full(VALUE self) {
+  struct EventStreamData *data;
+  TypedData_Get_Struct(self, struct EventStreamData, &event_stream_type, data);
+  return data->closed || data->subscribers >= data->max_subscribers ? Qtrue : Qfalse;
+}
+
+/**
+ * module ArtC
+ *   class EventStream
+ *     def close
+ *       @closed = true
+ *       @notifications << true
+ *       nil
+ *     end
+ *   end
+ * end
+ *
+ * Ends the streams of all subscribers, by way of the notifier. This does not take the mutex, so that it can be called
+ * from a signal trap.
+ */
+static VALUE event_stream_close(VALUE self) {
+  struct EventStreamData *data;
+  TypedData_Get_Struct(self, struct EventStreamData, &event_stream_type, data);
+
+  data->closed = 1;
+  rb_funcall(data->notifications, rb_intern("push"), 1, Qtrue);
+
+  return Qnil;
+}
+
+/**
+ * [No Ruby]
+ *
+ * The state of a single subscriber for the duration of `EventStream#stream_to`.
+ */
+struct EventStreamSubscription {
+  struct EventStreamData *data;
+  VALUE socket;
+  unsigned long cursor;
+};
+
+/**
+ * [No Ruby]
+ *
+ * Parses a `<boot>-<sequence>` frame ID, as sent back by a reconnecting subscriber in the `Last-Event-ID` header.
+ * Returns 0, rather than raising, for anything that is not such an ID.
+ */
+static int event_stream_parse_id(VALUE id, unsigned int *boot, unsigned long *sequence) {
+  if (!RB_TYPE_P(id, T_STRING)) {
+    return 0;
+  }
+  const char *p = RSTRING_PTR(id);
+  const char *end = p + RSTRING_LEN(id);
+
+  unsigned int b = 0;
+  const char *start = p;
+  for (; p < end && *p != '-'; p++) {
+    if (!isxdigit((unsigned char)*p) || b > (UINT_MAX >> 4)) {
+      return 0;
+    }
+    b = (b << 4) | (unsigned int)(isdigit((unsigned char)*p) ? *p - '0' : tolower((unsigned char)*p) - 'a' + 10);
+  }
+  if (p == start || p == end) {
+    return 0;
+  }
+
+  unsigned long s = 0;
+  start = ++p;
+  for (; p < end; p++) {
+    if (!isdigit((unsigned char)*p) || s > (ULONG_MAX - (*p - '0')) / 10) {
+      return 0;
+    }
+    s = s * 10 + (*p - '0');
+  }
+  if (p == start) {
+    return 0;
+  }
+
+  *boot = b;
+  *sequence = s;
+  return 1;
+}
+
+/**
+ * [No Ruby]
+ *
+ * Waits, with the mutex held, for a frame past the subscriber's cursor to be published, for the stream to be closed,
+ * or for the heartbeat interval to elapse. The notifier broadcasts with the mutex held, so nothing published or closed
+ * after checking can be missed.
+ */
+static VALUE event_stream_wait(VALUE arg) {
+  struct EventStreamSubscription *subscription = (struct EventStreamSubscription *)arg;
+  struct EventStreamData *data = subscription->data;
+  if (subscription->cursor == data->head && !data->closed) {
+    rb_funcall(data->published, rb_intern("wait"), 2, data->mutex, INT2FIX(EVENT_STREAM_HEARTBEAT_INTERVAL));
+  }
+  return Qnil;
+}
+
+/**
+ * [No Ruby]
+ *
+ * Writes frames to the subscriber for as long as it stays connected and the stream is open. Frames are the very same
+ * strings for all subscribers and are written straight to their sockets, without being copied.
+ *
+ * Writing to a slow subscriber only blocks its own thread; by the time it is writable again, the ring may have lapped
+ * its cursor, in which case it is skipped ahead to the oldest frame that is still retained.
+ */
+static VALUE event_stream_write_frames(VALUE arg) {
+  struct EventStreamSubscription *subscription = (struct EventStreamSubscription *)arg;
+  struct EventStreamData *data = subscription->data;
+
+  rb_hash_aset(data->sockets, subscription->socket, Qtrue);
+  rb_io_write(subscription->socket, event_stream_chunk(rb_str_new_cstr(": connected\n\n")));
+
+  while (!data->closed) {
+    if (subscription->cursor == data->head) {
+      rb_mutex_synchronize(data->mutex, event_stream_wait, arg);
+      // Still nothing new, let the subscriber (and us) know the connection is still alive
+      if (subscription->cursor == data->head && !data->closed) {
+        rb_io_write(subscription->socket, event_stream_chunk(rb_str_new_cstr(": heartbeat\n\n")));
+      }
+      continue;
+    }
+    if (data->head - subscription->cursor > EVENT_STREAM_CAPACITY) {
+      subscription->cursor = data->head - EVENT_STREAM_CAPACITY;
+    }
+    VALUE frame = data->frames[subscription->cursor % EVENT_STREAM_CAPACITY];
+    subscription->cursor++;
+    rb_io_write(subscription->socket, frame);
+  }
+
+  return Qnil;
+}
+
+/**
+ * [No Ruby]
+ *
+ * Writes frames until the subscriber disconnects.
+ */
+static VALUE event_stream_write_frames_until_disconnected(VALUE arg) {
+  return rb_rescue2(event_stream_write_frames, arg, event_stream_ignore_error, arg, rb_eIOError, rb_eSystemCallError,
+                    (VALUE)0);
+}
+
+/**
+ * [No Ruby]
+ *
+ * Gives back the subscriber's place, regardless of how its stream ended. The socket itself belongs to WEBrick.
+ */
+static VALUE event_stream_unsubscribe(VALUE arg) {
+  struct EventStreamSubscription *subscription = (struct EventStreamSubscription *)arg;
+  rb_hash_delete(subscription->data->sockets, subscription->socket);
+  subscription->data->subscribers--;
+  return Qnil;
+}
+
+/**
+ * module ArtC
+ *   class EventStream
+ *     def stream_to(socket, last_event_id)
+ *       return false if full?
+ *       @subscribers += 1
+ *       begin
+ *         cursor = @head
+ *         # Resume after `last_event_id` when the subscriber reconnects and those frames are still retained
+ *         if (match = /\A(\h+)-(\d+)\z/.match(last_event_id.to_s)) && match[1].hex == @boot
+ *           sequence = match[2].to_i
+ *           cursor = sequence + 1 if sequence < @head && @head - (sequence + 1) <= EVENT_STREAM_CAPACITY
+ *         end
+ *         # [No Ruby]
+ *         #
+ *         @sockets[socket] = true
+ *         # [No Ruby]
+ *         #
+ *         # Write every frame from `cursor` onwards to `socket`, skipping ahead when lapped by the ring.
+ *       rescue IOError, SystemCallError
+ *       ensure
+ *         @sockets.delete(socket)
+ *         @subscribers -= 1
+ *       end
+ *       true
+ *     end
+ *   end
+ * end
+ *
+ * The subscriber's place is taken and given back in here, so that it can never be leaked. Returns `false`, without
+ * writing anything, when there is no place left.
+ */
+static VALUE event_stream_stream_to(VALUE self, VALUE socket, VALUE last_event_id) {
+  struct EventStreamData *data;
+  TypedData_Get_Struct(self, struct EventStreamData, &event_stream_type, data);
+
+  if (data->closed || data->subscribers >= data->max_subscribers) {
+    return Qfalse;
+  }
+
+  struct EventStreamSubscription subscription = {.data = data, .socket = socket, .cursor = data->head};
+  unsigned int boot;
+  unsigned long sequence;
+  if (event_stream_parse_id(last_event_id, &boot, &sequence) && boot == data->boot && sequence < data->head &&
+      data->head - (sequence + 1) <= EVENT_STREAM_CAPACITY) {
+    subscription.cursor = sequence + 1;
+  }
+
+  data->subscribers++;
+  rb_ensure(event_stream_write_frames_until_disconnected, (VALUE)&subscription, event_stream_unsubscribe,
+            (VALUE)&subscription);
+  return Qtrue;
+}
 
 #pragma mark -
 #pragma mark Run Rack application
 
 /**
- * app = proc do |env, event_handler|
+ * app = proc do |env, context|
  *   is_post = env["REQUEST_METHOD"] == "POST"
  *   matches_route = env["PATH_INFO"] == "/webhooks/analytics"
  *   status = !is_post ? HTTP_STATUS_METHOD_NOT_ALLOWED : matches_route ? HTTP_STATUS_OK : HTTP_STATUS_NOT_FOUND
  *   if status == HTTP_STATUS_OK
  *     json = JSON.parse(env["rack.input"].read)
- *     event_handler.call(event)
+ *     classified_event = context.event_handler.call(event)
+ *     context.event_stream.publish(classified_event) unless classified_event.nil?
  *   end
  *   [status, {}, ["OK"]]
  * end
  */
-static VALUE app(RB_BLOCK_CALL_FUNC_ARGLIST(env, event_handler)) {
+static VALUE app(RB_BLOCK_CALL_FUNC_ARGLIST(env, context)) {
+  VALUE event_handler = rb_funcall(context, rb_intern("event_handler"), 0);
+  VALUE event_stream = rb_funcall(context, rb_intern("event_stream"), 0);
+
   VALUE request_method = rb_hash_fetch(env, rb_str_new_cstr("REQUEST_METHOD"));
   VALUE is_post = rb_str_equal(request_method, rb_str_new_cstr("POST"));
   VALUE request_path = rb_hash_fetch(env, rb_str_new_cstr("PATH_INFO"));
@@ -36,7 +496,10 @@ static VALUE app(RB_BLOCK_CALL_FUNC_ARGLIST(env, event_handler)) {
     VALUE request_body = rb_funcall(request_body_stream, rb_intern("read"), 0);
     VALUE rb_mJSON = rb_const_get(rb_cObject, rb_intern("JSON"));
     VALUE event = rb_funcall(rb_mJSON, rb_intern("parse"), 1, request_body);
-    rb_proc_call(event_handler, rb_ary_new3(1, event));
+    VALUE classified_event = rb_proc_call(event_handler, rb_ary_new3(1, event));
+    if (classified_event != Qnil) {
+      rb_funcall(event_stream, rb_intern("publish"), 1, classified_event);
+    }
   }
 
   VALUE headers = rb_hash_new();
@@ -50,19 +513,183 @@ static VALUE app(RB_BLOCK_CALL_FUNC_ARGLIST(env, event_handler)) {
   return response;
 }
 
+#pragma mark -
+#pragma mark Run event stream WEBrick servlet
+
+/**
+ * subscriber = proc do |chunked_socket, event_stream, last_event_id|
+ *   socket = chunked_socket.instance_variable_get(:@socket)
+ *   event_stream.stream_to(socket, last_event_id)
+ * end
+ *
+ * WEBrick hands the response body a wrapper around the client's socket that chunk-encodes every write. As frames are
+ * chunk-encoded already, they are written to the socket underneath, so that no copy is made per subscriber.
+ */
+static VALUE subscriber(RB_BLOCK_CALL_FUNC_ARGLIST(chunked_socket, subscription)) {
+  VALUE socket = rb_ivar_get(chunked_socket, rb_intern("@socket"));
+  VALUE event_stream = rb_ary_entry(subscription, 0);
+  VALUE last_event_id = rb_ary_entry(subscription, 1);
+  return rb_funcall(event_stream, rb_intern("stream_to"), 2, socket, last_event_id);
+}
+
+/**
+ * stream = proc do |req, res, event_stream|
+ *   if req.request_method != "GET"
+ *     res.status = HTTP_STATUS_METHOD_NOT_ALLOWED
+ *   elsif req.http_version < "1.1"
+ *     res.status = HTTP_STATUS_HTTP_VERSION_NOT_SUPPORTED
+ *   elsif event_stream.full?
+ *     res.status = HTTP_STATUS_SERVICE_UNAVAILABLE
+ *   else
+ *     last_event_id = req["Last-Event-ID"]
+ *     res["Content-Type"] = "text/event-stream"
+ *     res["Cache-Control"] = "no-cache"
+ *     res.chunked = true
+ *     res.body = proc { |chunked_socket| subscriber.call(chunked_socket, event_stream, last_event_id) }
+ *   end
+ * end
+ *
+ * The body is streamed by the WEBrick connection thread itself, for as long as the subscriber is connected. HTTP/1.0
+ * has no chunked responses, which WEBrick would instead try to buffer in full before sending.
+ *
+ * A subscriber that finds the stream full after all, because others took the last places in the meantime, gets an
+ * empty response and will reconnect.
+ */
+static VALUE stream(RB_BLOCK_CALL_FUNC_ARGLIST(req, event_stream)) {
+  VALUE res = argv[1];
+
+  VALUE request_method = rb_funcall(req, rb_intern("request_method"), 0);
+  VALUE http_version = rb_funcall(req, rb_intern("http_version"), 0);
+  if (rb_str_equal(request_method, rb_str_new_cstr("GET")) == Qfalse) {
+    rb_funcall(res, rb_intern("status="), 1, INT2FIX(HTTP_STATUS_METHOD_NOT_ALLOWED));
+  } else if (RTEST(rb_funcall(http_version, rb_intern("<"), 1, rb_str_new_cstr("1.1")))) {
+    rb_funcall(res, rb_intern("status="), 1, INT2FIX(HTTP_STATUS_HTTP_VERSION_NOT_SUPPORTED));
+  } else if (rb_funcall(event_stream, rb_intern("full?"), 0) == Qtrue) {
+    rb_funcall(res, rb_intern("status="), 1, INT2FIX(HTTP_STATUS_SERVICE_UNAVAILABLE));
+  } else {
+    VALUE last_event_id = rb_funcall(req, rb_intern("[]"), 1, rb_str_new_cstr("Last-Event-ID"));
+    VALUE subscription = rb_ary_new3(2, event_stream, last_event_id);
+    rb_funcall(res, rb_intern("[]="), 2, rb_str_new_cstr("Content-Type"), rb_str_new_cstr("text/event-stream"));
+    rb_funcall(res, rb_intern("[]="), 2, rb_str_new_cstr("Cache-Control"), rb_str_new_cstr("no-cache"));
+    rb_funcall(res, rb_intern("chunked="), 1, Qtrue);
+    rb_funcall(res, rb_intern("body="), 1, rb_proc_new(subscriber, subscription));
+  }
+
+  return Qnil;
+}
+
+/**
+ * mount_stream = proc do |server, event_stream|
+ *   server.mount_proc("/stream") { |req, res| stream.call(req, res, event_stream) }
+ * end
+ *
+ * The event stream is served by WEBrick directly, rather than by the Rack app, as Rack's WEBrick handler can only
+ * stream a response body through a pipe and a thread of its own per subscriber.
+ */
+static VALUE mount_stream(RB_BLOCK_CALL_FUNC_ARGLIST(server, event_stream)) {
+  VALUE path = rb_str_new_cstr("/stream");
+  return rb_funcall_with_block(server, rb_intern("mount_proc"), 1, &path, rb_proc_new(stream, event_stream));
+}
+
+#pragma mark -
+#pragma mark Start server
+
+/**
+ * raise_open_files_limit = proc do
+ *   wanted = HTTP_MAX_WEBHOOK_CLIENTS + HTTP_RESERVED_OPEN_FILES + EVENT_STREAM_MAX_SUBSCRIBERS
+ *   soft, hard = Process.getrlimit(:NOFILE)
+ *   begin
+ *     Process.setrlimit(:NOFILE, [wanted, hard].min) if soft < wanted
+ *   rescue SystemCallError
+ *   end
+ *   soft, _ = Process.getrlimit(:NOFILE)
+ *   (soft - HTTP_MAX_WEBHOOK_CLIENTS - HTTP_RESERVED_OPEN_FILES).clamp(0, EVENT_STREAM_MAX_SUBSCRIBERS)
+ * end
+ *
+ * Raises the limit of open files, which defaults to 256 on macOS, to make room for all subscribers and returns how many
+ * subscribers fit. Should raising it not be allowed, fewer subscribers are accepted, as the webhooks must never run out
+ * of open files.
+ */
+static int raise_open_files_limit(void) {
+  rlim_t wanted = HTTP_MAX_WEBHOOK_CLIENTS + HTTP_RESERVED_OPEN_FILES + EVENT_STREAM_MAX_SUBSCRIBERS;
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+    return 0;
+  }
+  if (limit.rlim_cur < wanted) {
+    struct rlimit raised = {.rlim_cur = limit.rlim_max < wanted ? limit.rlim_max : wanted, .rlim_max = limit.rlim_max};
+    if (setrlimit(RLIMIT_NOFILE, &raised) == 0) {
+      limit = raised;
+    }
+  }
+
+  rlim_t reserved = HTTP_MAX_WEBHOOK_CLIENTS + HTTP_RESERVED_OPEN_FILES;
+  if (limit.rlim_cur <= reserved) {
+    return 0;
+  }
+  rlim_t available = limit.rlim_cur - reserved;
+  return available < EVENT_STREAM_MAX_SUBSCRIBERS ? (int)available : EVENT_STREAM_MAX_SUBSCRIBERS;
+}
+
+/**
+ * shutdown = proc do |signo, event_stream|
+ *   trap("INT", "DEFAULT")
+ *   trap("TERM", "DEFAULT")
+ *   event_stream.close
+ *   Rack::Handler::WEBrick.shutdown
+ * end
+ *
+ * WEBrick waits for all of its connection threads to finish before it stops, including those streaming events, which is
+ * why the event stream has to be closed first. Should that still take too long, a second signal exits right away.
+ */
+static VALUE shutdown(RB_BLOCK_CALL_FUNC_ARGLIST(signo, event_stream)) {
+  rb_funcall(rb_mKernel, rb_intern("trap"), 2, rb_str_new_cstr("INT"), rb_str_new_cstr("DEFAULT"));
+  rb_funcall(rb_mKernel, rb_intern("trap"), 2, rb_str_new_cstr("TERM"), rb_str_new_cstr("DEFAULT"));
+
+  rb_funcall(event_stream, rb_intern("close"), 0);
+
+  VALUE rb_mRack = rb_const_get(rb_cObject, rb_intern("Rack"));
+  VALUE rb_mRackHandler = rb_const_get(rb_mRack, rb_intern("Handler"));
+  VALUE rb_cRackHandlerWEBrick = rb_const_get(rb_mRackHandler, rb_intern("WEBrick"));
+  return rb_funcall(rb_cRackHandlerWEBrick, rb_intern("shutdown"), 0);
+}
+
 /**
  * def ArtC.start_server(&event_handler)
- *   Rack::Handler::WEBrick.run(proc { |env| app.call(env, event_handler) })
+ *   max_subscribers = raise_open_files_limit.call
+ *   event_stream = EventStream.new(max_subscribers)
+ *   context = Struct.new(:event_handler, :event_stream).new(event_handler, event_stream)
+ *   trap("INT") { |signo| shutdown.call(signo, event_stream) }
+ *   trap("TERM") { |signo| shutdown.call(signo, event_stream) }
+ *   Rack::Handler::WEBrick.run(proc { |env| app.call(env, context) },
+ *                              MaxClients: HTTP_MAX_WEBHOOK_CLIENTS + max_subscribers) do |server|
+ *     mount_stream.call(server, event_stream)
+ *   end
  * end
+ *
+ * Every event stream subscriber occupies a WEBrick connection for as long as it listens, so room is made for them on
+ * top of the connections reserved for webhooks.
  */
 static VALUE start_server(VALUE self) {
   VALUE event_handler = rb_block_proc();
+  int subscribers = raise_open_files_limit();
+  VALUE event_stream = rb_class_new_instance(1, (VALUE[]){INT2FIX(subscribers)}, cEventStream);
+
+  VALUE cServerContext = rb_struct_define(NULL, "event_handler", "event_stream", NULL);
+  VALUE members[2] = {event_handler, event_stream};
+  VALUE context = rb_class_new_instance(2, members, cServerContext);
+
+  rb_funcall(rb_mKernel, rb_intern("trap"), 2, rb_str_new_cstr("INT"), rb_proc_new(shutdown, event_stream));
+  rb_funcall(rb_mKernel, rb_intern("trap"), 2, rb_str_new_cstr("TERM"), rb_proc_new(shutdown, event_stream));
 
   VALUE rb_mRack = rb_const_get(rb_cObject, rb_intern("Rack"));
   VALUE rb_mRackHandler = rb_const_get(rb_mRack, rb_intern("Handler"));
   VALUE rb_cRackHandlerWEBrick = rb_const_get(rb_mRackHandler, rb_intern("WEBrick"));
 
-  rb_funcall(rb_cRackHandlerWEBrick, rb_intern("run"), 1, rb_proc_new(app, event_handler));
+  VALUE options = rb_hash_new();
+  rb_hash_aset(options, ID2SYM(rb_intern("MaxClients")), INT2FIX(HTTP_MAX_WEBHOOK_CLIENTS + subscribers));
+  VALUE argv[2] = {rb_proc_new(app, context), options};
+  rb_funcall_with_block(rb_cRackHandlerWEBrick, rb_intern("run"), 2, argv, rb_proc_new(mount_stream, event_stream));
 
   return Qnil;
 }
@@ -76,6 +703,15 @@ static VALUE start_server(VALUE self) {
  *
  * module ArtC
  *   def self.start_server; end
+ *
+ *   class EventStream
+ *     def self.allocate; end
+ *     def initialize(max_subscribers); end
+ *     def publish(classified_event); end
+ *     def full?; end
+ *     def stream_to(socket, last_event_id); end
+ *     def close; end
+ *   end
  * end
  */
 void Init_ArtC_server(void) {
@@ -84,4 +720,12 @@ void Init_ArtC_server(void) {
 
   mArtC = rb_const_get(rb_cObject, rb_intern("ArtC"));
   rb_define_singleton_method(mArtC, "start_server", start_server, 0);
+
+  cEventStream = rb_define_class_under(mArtC, "EventStream", rb_cObject);
+  rb_define_alloc_func(cEventStream, event_stream_alloc);
+  rb_define_method(cEventStream, "initialize", event_stream_initialize, 1);
+  rb_define_method(cEventStream, "publish", event_stream_publish, 1);
+  rb_define_method(cEventStream, "full?", event_stream_is_full, 0);
+  rb_define_method(cEventStream, "stream_to", event_stream_stream_to, 2);
+  rb_define_method(cEventStream, "close", event_stream_close, 0);
 }
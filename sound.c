@@ -292,6 +292,7 @@ home:
  *         @last_played_note = (@last_played_note + 1) % 7
  *         absolute_note_to_play = scale_note_to_absolute(@last_played_note) + @octave_offset
  *         @sound.play(@channel, absolute_note_to_play, velocity)
+ *         absolute_note_to_play
  *       end
  *     end
  *   end
@@ -310,9 +311,20 @@ static VALUE sound_channel_play(VALUE self, VALUE velocity) {
   VALUE channel = rb_ivar_get(self, rb_intern("channel"));
   rb_funcall(sound, rb_intern("play"), 3, channel, absolute_note_to_play, velocity);
 
-  return Qnil;
+  return absolute_note_to_play;
 }
 
+/**
+ * module ArtC
+ *   class Sound
+ *     class Channel
+ *       attr_reader :channel
+ *     end
+ *   end
+ * end
+ */
+static VALUE sound_channel_get_channel(VALUE self) { return rb_ivar_get(self, rb_intern("channel")); }
+
 /**
  * Takes a note in the C major scale and converts it to the absolute note.
  *
@@ -375,6 +387,7 @@ static VALUE sound_channel_scale_note_to_absolute(VALUE self, VALUE note) {
  *       def initialize(sound, channel, octave); end
  *       def bank=(bank); end
  *       end play(velocity); end
+ *       def channel; end
  *       private
  *       def scale_note_to_absolute(note); end
  *     end
@@ -394,5 +407,6 @@ void Init_ArtC_sound() {
   rb_define_method(cSoundChannel, "initialize", sound_channel_initialize, 3);
   rb_define_method(cSoundChannel, "bank=", sound_channel_set_bank, 1);
   rb_define_method(cSoundChannel, "play", sound_channel_play, 1);
+  rb_define_method(cSoundChannel, "channel", sound_channel_get_channel, 0);
   rb_define_private_method(cSoundChannel, "scale_note_to_absolute", sound_channel_scale_note_to_absolute, 1);
 }